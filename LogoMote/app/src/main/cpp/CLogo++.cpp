@@ -4,6 +4,7 @@
 #include <cstring>
 #include <string>
 #include <iostream>
+#include "LogoDispatcher.hpp"
 #else
 #include <Arduino.h>
 #endif
@@ -11,85 +12,158 @@
 extern "C"
 {
     #include "CLogo.h"
-    int LogoAvailable_C(LogoData* logoData) {
-        return LogoAvailable_CXX((LogoClient*)logoData->_logo_client);
-    }
-    size_t LogoRead_C(LogoData* logoData, char* buffer, size_t length) {
-        return LogoRead_CXX((LogoClient*)logoData->_logo_client, buffer, length);
-    }
-    void LogoWrite_C(LogoData* logoData, const char* msg, size_t length) {
+}
+
+static int _hooks_available(LogoData* logoData) {
+    return LogoAvailable_CXX != NULL ? LogoAvailable_CXX((LogoClient*)logoData->_logo_client) : 0;
+}
+
+static size_t _hooks_read(LogoData* logoData, char* buffer, size_t length) {
+    return LogoRead_CXX != NULL ? LogoRead_CXX((LogoClient*)logoData->_logo_client, buffer, length) : 0;
+}
+
+static void _hooks_write(LogoData* logoData, const char* msg, size_t length) {
+    if(LogoWrite_CXX != NULL)
         LogoWrite_CXX((LogoClient*)logoData->_logo_client, msg, length);
-    }
 }
 
-LogoClient::LogoClient(char *name, size_t bufferSize) {
+const LogoTransport LogoHooksTransport = {_hooks_available, _hooks_read, _hooks_write};
+
+static int _queued_available(LogoData* logoData) {
+    return ((LogoClient*)logoData->_logo_client)->_raw_available();
+}
+
+static size_t _queued_read(LogoData* logoData, char* buffer, size_t length) {
+    return ((LogoClient*)logoData->_logo_client)->_raw_read(buffer, length);
+}
+
+static void _queued_write(LogoData* logoData, const char* msg, size_t length) {
+    ((LogoClient*)logoData->_logo_client)->_write(msg, length);
+}
+
+/// Installed while the outbound queue is enabled, writes go through the queue
+static const LogoTransport QueuedTransport = {_queued_available, _queued_read, _queued_write};
+
+LogoClient::LogoClient(const LogoTransport* transport, char *name, size_t bufferSize) {
     this->Data = create_logo_data(name);
     this->Data.BufferSize = bufferSize;
     this->Data._logo_client = (void*)this;
     this->Data.OnMessage = _message_proxy;
+    this->Data.OnClients = _clients_proxy;
+    this->SetTransport(transport != NULL ? transport : &LogoHooksTransport);
 }
 
-LogoClient::LogoClient(String name, size_t bufferSize) : LogoClient(_copy_str(name), bufferSize) {
+LogoClient::LogoClient(const LogoTransport* transport, String name, size_t bufferSize) : LogoClient(transport, _copy_str(name), bufferSize) {
 }
 
-LogoClient::LogoClient(char *name, void (*onMessage)(LogoClient*, const char*, MessageTypeReceive, const char*), size_t bufferSize) : LogoClient(name, bufferSize) {
+LogoClient::LogoClient(const LogoTransport* transport, char *name, void (*onMessage)(LogoClient*, const char*, MessageTypeReceive, const char*), size_t bufferSize) : LogoClient(transport, name, bufferSize) {
     this->OnMessage.OnMessageChar = onMessage;
     this->OnMessageMode = MSGMODE_CHAR;
 }
 
-LogoClient::LogoClient(String name, void (*onMessage)(LogoClient*, const String&, MessageTypeReceive, const String&), size_t bufferSize) : LogoClient(name, bufferSize) {
+LogoClient::LogoClient(const LogoTransport* transport, String name, void (*onMessage)(LogoClient*, const String&, MessageTypeReceive, const String&), size_t bufferSize) : LogoClient(transport, name, bufferSize) {
     this->OnMessage.OnMessageStr = onMessage;
     this->OnMessageMode = MSGMODE_STR;
 }
 
 LogoClient::~LogoClient() {
+#ifndef ARDUINO
+    if(this->Dispatcher != NULL)
+        this->Dispatcher->Drain(this);
+#endif
     logo_free(&this->Data);
+    logo_route_free(&this->ServerRoute);
+    if(this->FrameBuffer != NULL)
+        free(this->FrameBuffer);
 }
 
 void LogoClient::Reset() {
+#ifndef ARDUINO
+    if(this->Dispatcher != NULL)
+        this->Dispatcher->Drain(this);
+#endif
     logo_reset(&this->Data);
+    this->NumProbes = 0;
+    this->SkipReplies = 0;
+    this->PendingResults = 0;
+    this->MirrorSkip = 0;
+    this->MirrorQueryQueued = false;
+    this->MirrorQueryPending = false;
+    logo_route_free(&this->ServerRoute);
+    for(size_t i = 0; i < LOGO_PRIORITIES; i++)
+        this->Lanes[i].Clear();
 }
 
-void LogoClient::SendRaw(MessageTypeSend messageType, const char** parts, size_t partsLength, const char* append) {
+void LogoClient::SendRaw(MessageTypeSend messageType, const char** parts, size_t partsLength, const char* append, LogoPriority priority) {
+    //The first part is the sender
+    size_t results = messageType == SND_COMMAND && partsLength > 1 ? this->_server_results(parts + 1, partsLength - 1) : 0;
+    this->_send_begin(priority, results, results > 0 && append != NULL ? strlen(append) : 0, false);
     logo_send_raw(&this->Data, messageType, parts, partsLength, append);
+    this->_send_end(true, append);
 }
 
-void LogoClient::SendRaw(MessageTypeSend messageType, String* parts, size_t partsLength, const String& append) {
+void LogoClient::SendRaw(MessageTypeSend messageType, String* parts, size_t partsLength, const String& append, LogoPriority priority) {
     auto partsBuffer = (char**)malloc(partsLength * sizeof(char*));
     for(size_t i = 0; i < partsLength; i++) {
         partsBuffer[i] = _copy_str(parts[i]);
     }
     char* appendBuffer = _copy_str(append);
-    this->SendRaw(messageType, const_cast<const char**>(partsBuffer), partsLength, appendBuffer);
+    this->SendRaw(messageType, const_cast<const char**>(partsBuffer), partsLength, appendBuffer, priority);
     for(size_t i = 0;i < partsLength; i++)
         free(partsBuffer[i]);
     free(partsBuffer);
     free(appendBuffer);
 }
 
-void LogoClient::SendMessage(MessageTypeSend messageType, const char* message, const char** clients, size_t numClients) {
+void LogoClient::SendMessage(MessageTypeSend messageType, const char* message, const char** clients, size_t numClients, LogoPriority priority) {
+    size_t results = messageType == SND_COMMAND ? this->_server_results(clients, numClients) : 0;
+    this->_send_begin(priority, results, results > 0 && message != NULL ? strlen(message) : 0, false);
     logo_send_message(&this->Data, messageType, message, clients, numClients);
+    this->_send_end(true, message);
 }
 
-void LogoClient::SendMessage(MessageTypeSend messageType, const char* message, const char *client) {
-    this->SendMessage(messageType, message, &client, 1);
+void LogoClient::SendMessage(MessageTypeSend messageType, const char* message, const char *client, LogoPriority priority) {
+    this->SendMessage(messageType, message, &client, 1, priority);
 }
 
-void LogoClient::SendMessage(MessageTypeSend messageType, const String& message, String* clients, size_t numClients) {
+void LogoClient::SendMessage(MessageTypeSend messageType, const String& message, String* clients, size_t numClients, LogoPriority priority) {
     auto clientsBuffer = (char**)malloc(numClients * sizeof(char*));
     for(size_t i = 0; i < numClients; i++) {
         clientsBuffer[i] = _copy_str(clients[i]);
     }
     char* messageBuffer = _copy_str(message);
-    this->SendMessage(messageType, messageBuffer, const_cast<const char**>(clientsBuffer), numClients);
+    this->SendMessage(messageType, messageBuffer, const_cast<const char**>(clientsBuffer), numClients, priority);
     for(size_t i = 0;i < numClients; i++)
         free(clientsBuffer[i]);
     free(clientsBuffer);
     free(messageBuffer);
 }
 
-void LogoClient::SendMessage(MessageTypeSend messageType, const String& message, String client) {
-    this->SendMessage(messageType, message, &client, 1);
+void LogoClient::SendMessage(MessageTypeSend messageType, const String& message, String client, LogoPriority priority) {
+    this->SendMessage(messageType, message, &client, 1, priority);
+}
+
+int LogoClient::SendCommand(const char* command, size_t length, LogoPriority priority) {
+    const char* server = logo_server(&this->Data);
+    if(!this->Data.Connected || server == NULL)
+        return 0;
+    if(this->ServerRoute.Header == NULL && !logo_route_init(&this->Data, &this->ServerRoute, SND_COMMAND, &server, 1))
+        return 0;
+    if(this->FrameBuffer == NULL)
+        this->FrameBuffer = (char*)malloc((this->Data.BufferSize + 8) * sizeof(char));
+    this->_send_begin(priority, 1, length, false);
+    size_t written = logo_send_routed(&this->Data, &this->ServerRoute, command, length, this->FrameBuffer);
+    this->_send_end(written > 0, command);
+    return written > 0;
+}
+
+size_t LogoClient::MaxMessageLength(const char** clients, size_t numClients) {
+    return logo_max_message_length(&this->Data, clients, numClients);
+}
+
+size_t LogoClient::MaxMessageLength(const String& client) {
+    const char* clientChars = client.c_str();
+    return this->MaxMessageLength(&clientChars, 1);
 }
 
 void LogoClient::Join() {
@@ -97,13 +171,234 @@ void LogoClient::Join() {
 }
 
 void LogoClient::UpdateClients() {
+    if(!this->Data.Connected) {
+        logo_update_clients(&this->Data);
+        return;
+    }
+    this->ProbeStart = logo_micros();
+    this->Probing = true;
     logo_update_clients(&this->Data);
+    this->Probing = false;
+    if(!this->Queued)
+        this->_probe_written(this->ProbeStart);
+}
+
+void LogoClient::_probe_written(unsigned long start) {
+    //Replies arrive in order, when every slot is taken ignore the replies of the pending queries instead of mismatching them
+    if(this->NumProbes == LOGO_PROBE_SLOTS) {
+        this->SkipReplies += this->NumProbes;
+        this->NumProbes = 0;
+    }
+    unsigned long sent = logo_micros();
+    this->SendDelay.Add(sent - start);
+    this->ProbeSent[(this->ProbeHead + this->NumProbes++) % LOGO_PROBE_SLOTS] = sent;
 }
 
 void LogoClient::Update() {
+    if(this->ProbeInterval > 0 && this->Data.Connected && logo_micros() - this->LastProbe >= this->ProbeInterval)
+        this->Probe();
+    if(this->ReconcileInterval > 0 && this->Data.Connected && logo_micros() - this->LastReconcile >= this->ReconcileInterval)
+        this->ReconcileMirror();
+    if(this->Queued)
+        this->Flush(this->FramesPerUpdate);
     logo_update(&this->Data);
 }
 
+void LogoClient::Probe() {
+    if(!this->Data.Connected)
+        return;
+    this->LastProbe = logo_micros();
+    this->UpdateClients();
+}
+
+void LogoClient::SetProbeInterval(unsigned long intervalMicros) {
+    this->ProbeInterval = intervalMicros;
+}
+
+unsigned long LogoClient::EstimatedQueueDelay() {
+    return this->SendDelay.Mean() + this->RoundTrip.Mean() / 2;
+}
+
+void LogoClient::ReconcileMirror() {
+    if(this->Mirror == NULL || !this->Data.Connected || this->MirrorQueryQueued || this->MirrorQueryPending)
+        return;
+    this->LastReconcile = logo_micros();
+    this->MirrorQueryQueued = true;
+    String query = this->Mirror->QueryCommand();
+    this->_send_begin(PRIORITY_NORMAL, 1, 0, true);
+    logo_send_message_single(&this->Data, SND_COMMAND, query.c_str(), logo_server(&this->Data));
+    this->_send_end(true, NULL);
+}
+
+void LogoClient::SetReconcileInterval(unsigned long intervalMicros) {
+    this->ReconcileInterval = intervalMicros;
+}
+
+size_t LogoClient::_server_results(const char** clients, size_t numClients) {
+    const char* server = logo_server(&this->Data);
+    if(server == NULL)
+        return 0;
+    size_t results = 0;
+    for(size_t i = 0; i < numClients; i++) {
+        if(strcmp(clients[i], server) == 0)
+            results++;
+    }
+    return results;
+}
+
+void LogoClient::_send_begin(LogoPriority priority, size_t results, size_t commandLength, bool mirrorQuery) {
+    //Invalid classes are sent as normal frames, the priority indexes the lanes
+    this->SendPriority = (unsigned)priority < LOGO_PRIORITIES ? priority : PRIORITY_NORMAL;
+    this->SendResults = results;
+    this->SendCommandLength = commandLength;
+    this->SendMirrorQuery = mirrorQuery;
+    this->SendQueued = false;
+}
+
+void LogoClient::_send_end(bool sent, const char* command) {
+    //Queued frames are accounted for by Flush, when they get on the wire
+    if(sent && !this->SendQueued)
+        this->_frame_written(this->SendResults, command, this->SendCommandLength, this->SendMirrorQuery);
+    this->_send_begin(PRIORITY_NORMAL, 0, 0, false);
+}
+
+void LogoClient::_frame_written(size_t results, const char* command, size_t commandLength, bool mirrorQuery) {
+    //Results of the server arrive in the order the frames were written, skip the ones of the commands written before the query
+    if(mirrorQuery) {
+        this->MirrorSkip = this->PendingResults;
+        this->MirrorQueryQueued = false;
+        this->MirrorQueryPending = true;
+        if(this->Mirror != NULL)
+            this->Mirror->_query_sent();
+    }
+    this->PendingResults += results;
+    if(!mirrorQuery && results > 0 && commandLength > 0 && this->Mirror != NULL)
+        this->Mirror->Apply(String(command, commandLength).c_str());
+}
+
+int LogoClient::_result_received(const char* sender, const char* message) {
+    const char* server = logo_server(&this->Data);
+    if(server == NULL || strcmp(sender, server) != 0)
+        return 0;
+    if(this->PendingResults > 0)
+        this->PendingResults--;
+    if(!this->MirrorQueryPending)
+        return 0;
+    if(this->MirrorSkip > 0) {
+        this->MirrorSkip--;
+        return 0;
+    }
+    this->MirrorQueryPending = false;
+    //A result that isn't the state of the turtle is passed on to OnMessage
+    return this->Mirror != NULL && this->Mirror->Reconcile(message);
+}
+
+void LogoClient::SetOutboundQueue(bool enabled, size_t framesPerUpdate) {
+    if(!enabled)
+        this->Flush();
+    this->Queued = enabled;
+    this->FramesPerUpdate = framesPerUpdate;
+    this->Data.Transport = enabled ? &QueuedTransport : this->TransportTable;
+}
+
+void LogoClient::SetTransport(const LogoTransport* transport) {
+    this->TransportTable = transport;
+    this->Data.Transport = this->Queued ? &QueuedTransport : transport;
+}
+
+size_t LogoClient::Flush(size_t maxFrames) {
+    size_t written = 0;
+    while(maxFrames == 0 || written < maxFrames) {
+        //Look for the highest priority at every frame boundary
+        LogoFrame* frame = NULL;
+        LogoLane* lane = NULL;
+        for(size_t i = 0; i < LOGO_PRIORITIES && frame == NULL; i++) {
+            lane = &this->Lanes[i];
+            frame = lane->Pop();
+        }
+        if(frame == NULL)
+            break;
+        this->_raw_write(frame->Bytes(), frame->Length);
+        lane->Latency.Add(logo_micros() - frame->Queued);
+        lane->Sent++;
+        if(frame->Probe)
+            this->_probe_written(frame->Queued);
+        this->_frame_written(frame->Results, frame->Bytes() + frame->Length - frame->CommandLength, frame->CommandLength, frame->MirrorQuery);
+        free(frame);
+        written++;
+    }
+    return written;
+}
+
+const LogoLane& LogoClient::GetLane(LogoPriority priority) {
+    return this->Lanes[(unsigned)priority < LOGO_PRIORITIES ? priority : PRIORITY_NORMAL];
+}
+
+void LogoClient::_write(const char* msg, size_t length) {
+    //Join and its client query are written immediately, logo_join doesn't call Update
+    if(!this->Queued || !this->Data.Connected) {
+        this->_raw_write(msg, length);
+        return;
+    }
+    LogoLane* lane = &this->Lanes[this->SendPriority];
+    if(this->SendPriority == PRIORITY_COALESCE) {
+        //Replaced frames never reach the server, so they aren't counted as pending results nor applied to the mirror
+        while(LogoFrame* replaced = lane->Pop()) {
+            lane->Coalesced++;
+            free(replaced);
+        }
+    }
+    //A dropped frame isn't written either
+    this->SendQueued = true;
+    LogoFrame* frame = lane->Push(msg, length);
+    if(frame == NULL) {
+        if(this->SendMirrorQuery)
+            this->MirrorQueryQueued = false;
+        return;
+    }
+    frame->Results = this->SendResults;
+    frame->Probe = this->Probing;
+    frame->MirrorQuery = this->SendMirrorQuery;
+    frame->CommandLength = this->SendCommandLength;
+}
+
+void LogoClient::_dispatch(const char* sender, MessageTypeReceive messageType, const char* message) {
+    switch(this->OnMessageMode) {
+        case MSGMODE_CHAR:
+            this->OnMessage.OnMessageChar(this, sender, messageType, message);
+            break;
+        case MSGMODE_STR:
+            this->OnMessage.OnMessageStr(this, String(sender), messageType, String(message));
+            break;
+        case MSGMODE_NONE:
+            break;
+    }
+}
+
+int LogoClient::_raw_available() {
+    return this->TransportTable->Available(&this->Data);
+}
+
+size_t LogoClient::_raw_read(char* buffer, size_t length) {
+    return this->TransportTable->Read(&this->Data, buffer, length);
+}
+
+void LogoClient::_raw_write(const char* msg, size_t length) {
+    this->TransportTable->Write(&this->Data, msg, length);
+}
+
+void LogoClient::_clients_received() {
+    if(this->SkipReplies > 0) {
+        this->SkipReplies--;
+        return;
+    }
+    if(this->NumProbes == 0)
+        return;
+    this->RoundTrip.Add(logo_micros() - this->ProbeSent[this->ProbeHead]);
+    this->ProbeHead = (this->ProbeHead + 1) % LOGO_PROBE_SLOTS;
+    this->NumProbes--;
+}
+
 int LogoClient::Connected() {
     return this->Data.Connected;
 }
@@ -142,14 +437,19 @@ void _message_proxy(LogoData* logoData, const char* sender, MessageTypeReceive m
     if(logoData->_logo_client == NULL)
         return;
     auto client = (LogoClient*)logoData->_logo_client;
-    switch(client->OnMessageMode) {
-        case LogoClient::MSGMODE_CHAR:
-            client->OnMessage.OnMessageChar(client, sender, messageType, message);
-            break;
-        case LogoClient::MSGMODE_STR:
-            client->OnMessage.OnMessageStr(client, String(sender), messageType, String(message));
-            break;
-        case LogoClient::MSGMODE_NONE:
-            break;
+    if(messageType == RCV_RESULT && client->_result_received(sender, message))
+        return;
+#ifndef ARDUINO
+    if(client->Dispatcher != NULL && client->OnMessageMode != LogoClient::MSGMODE_NONE) {
+        client->Dispatcher->Post(client, sender, messageType, message);
+        return;
     }
+#endif
+    client->_dispatch(sender, messageType, message);
+}
+
+void _clients_proxy(LogoData* logoData) {
+    if(logoData->_logo_client == NULL)
+        return;
+    ((LogoClient*)logoData->_logo_client)->_clients_received();
 }
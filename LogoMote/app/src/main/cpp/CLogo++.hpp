@@ -12,11 +12,57 @@ extern "C" {
 #include "CLogo.h"
 }
 
+#include "LogoLatency.hpp"
+#include "LogoLanes.hpp"
+#include "TurtleMirror.hpp"
+
+class LogoDispatcher;
+
+/// Maximum number of client queries whose round trip is timed at once
+#define LOGO_PROBE_SLOTS 8
+
 /// Provides a wrapper object for LogoData
 class LogoClient {
     protected:
         LogoData Data;
         void Reset();
+
+        unsigned long ProbeSent[LOGO_PROBE_SLOTS];
+        size_t ProbeHead = 0;
+        size_t NumProbes = 0;
+        size_t SkipReplies = 0;
+        unsigned long ProbeInterval = 0;
+        unsigned long LastProbe = 0;
+        bool Probing = false;
+        unsigned long ProbeStart = 0;
+        void _probe_written(unsigned long start);
+
+        size_t PendingResults = 0;
+        size_t MirrorSkip = 0;
+        bool MirrorQueryQueued = false;
+        bool MirrorQueryPending = false;
+        unsigned long ReconcileInterval = 0;
+        unsigned long LastReconcile = 0;
+        size_t _server_results(const char** clients, size_t numClients);
+
+        LogoLane Lanes[LOGO_PRIORITIES];
+        bool Queued = false;
+        size_t FramesPerUpdate = 0;
+        LogoPriority SendPriority = PRIORITY_NORMAL;
+        size_t SendResults = 0;
+        size_t SendCommandLength = 0;
+        bool SendMirrorQuery = false;
+        bool SendQueued = false;
+        void _send_begin(LogoPriority priority, size_t results, size_t commandLength, bool mirrorQuery);
+        void _send_end(bool sent, const char* command);
+        void _frame_written(size_t results, const char* command, size_t commandLength, bool mirrorQuery);
+
+        char* FrameBuffer = NULL;
+        LogoRoute ServerRoute = {NULL, 0};
+
+        /// Functions of the transport, LogoHooksTransport if the client implements the global LogoX_CXX hooks
+        const LogoTransport* TransportTable = NULL;
+        void SetTransport(const LogoTransport* transport);
     public:
         /// The type of OnMessage event to call
         enum {
@@ -37,22 +83,88 @@ class LogoClient {
             void (*OnMessageStr)(LogoClient*, const String&, MessageTypeReceive, const String&);
         } OnMessage;
 
+        /// Round trip times of client queries (time from sending the query to receiving the list of clients)
+        LatencyHistogram RoundTrip;
+
+        /// Time from starting a client query until its frame got on the wire (includes waiting in the outbound queue)
+        LatencyHistogram SendDelay;
+
+        /// Optional local model of the turtle, updated from the commands sent to the server (not owned by the client)
+        TurtleMirror* Mirror = NULL;
+
+        /// Optional worker pool calling the OnMessage event outside of Update (not owned by the client, not available on Arduino)
+        /// The client's pending messages are discarded when it's reset or destroyed, the pool has to outlive the client
+        LogoDispatcher* Dispatcher = NULL;
 
-        explicit LogoClient(char* name, size_t bufferSize = 1024);
-        explicit LogoClient(String name, size_t bufferSize = 1024);
-        LogoClient(char* name, void (*onMessage)(LogoClient*, const char*, MessageTypeReceive, const char*), size_t bufferSize = 1024);
-        LogoClient(String name, void (*onMessage)(LogoClient*, const String&, MessageTypeReceive, const String&), size_t bufferSize = 1024);
+        /// @param transport Functions of the transport, called with the client's LogoData (LogoHooksTransport when NULL)
+        LogoClient(const LogoTransport* transport, char* name, size_t bufferSize = 1024);
+        LogoClient(const LogoTransport* transport, String name, size_t bufferSize = 1024);
+        LogoClient(const LogoTransport* transport, char* name, void (*onMessage)(LogoClient*, const char*, MessageTypeReceive, const char*), size_t bufferSize = 1024);
+        LogoClient(const LogoTransport* transport, String name, void (*onMessage)(LogoClient*, const String&, MessageTypeReceive, const String&), size_t bufferSize = 1024);
         virtual ~LogoClient();
-        void SendRaw(MessageTypeSend messageType, const char** parts, size_t partsLength, const char* append);
-        void SendRaw(MessageTypeSend messageType, String* parts, size_t partsLength, const String& append);
-        void SendMessage(MessageTypeSend messageType, const char* message, const char** clients, size_t numClients);
-        void SendMessage(MessageTypeSend messageType, const char* message, const char* client);
-        void SendMessage(MessageTypeSend messageType, const String& message, String* clients, size_t numClients);
-        void SendMessage(MessageTypeSend messageType, const String& message, String client);
+        void SendRaw(MessageTypeSend messageType, const char** parts, size_t partsLength, const char* append, LogoPriority priority = PRIORITY_NORMAL);
+        void SendRaw(MessageTypeSend messageType, String* parts, size_t partsLength, const String& append, LogoPriority priority = PRIORITY_NORMAL);
+        void SendMessage(MessageTypeSend messageType, const char* message, const char** clients, size_t numClients, LogoPriority priority = PRIORITY_NORMAL);
+        void SendMessage(MessageTypeSend messageType, const char* message, const char* client, LogoPriority priority = PRIORITY_NORMAL);
+        void SendMessage(MessageTypeSend messageType, const String& message, String* clients, size_t numClients, LogoPriority priority = PRIORITY_NORMAL);
+        void SendMessage(MessageTypeSend messageType, const String& message, String client, LogoPriority priority = PRIORITY_NORMAL);
+
+        /// Send a command to the server through a cached route, building the frame in a reused buffer
+        /// Doesn't allocate memory unless Mirror is set or the frame is queued
+        /// @param command The command (doesn't have to be null-terminated)
+        /// @param length Length of the command
+        /// @param priority Priority of the frame
+        /// @return 1 if the command was sent, 0 if not connected or the command doesn't fit into a frame
+        int SendCommand(const char* command, size_t length, LogoPriority priority = PRIORITY_NORMAL);
+        size_t MaxMessageLength(const char** clients, size_t numClients);
+        size_t MaxMessageLength(const String& client);
         void Join();
         void UpdateClients();
         void Update();
 
+        /// Query the clients to take a round trip sample
+        void Probe();
+
+        /// Send a probe from Update periodically
+        /// @param intervalMicros Time between probes in microseconds (0 disables probing)
+        void SetProbeInterval(unsigned long intervalMicros);
+
+        /// Estimate the time a message takes to reach the server (send delay plus half of the round trip)
+        /// @return The estimate in microseconds (0 if there are no samples yet)
+        unsigned long EstimatedQueueDelay();
+
+        /// Query the state of the turtle from the server and set Mirror to it once the result arrives
+        /// The result is matched by counting the results of the commands written before the query, so the server has to reply to every command sent to it
+        /// A result that can't be parsed is counted by Mirror->FailedReconciles and passed to OnMessage
+        void ReconcileMirror();
+
+        /// Reconcile Mirror from Update periodically
+        /// @param intervalMicros Time between queries in microseconds (0 disables reconciling)
+        void SetReconcileInterval(unsigned long intervalMicros);
+
+        /// Queue the frames while connected and write them from Update, by priority
+        /// Without the queue (default) the frames are written immediately and the priority is ignored
+        /// @param enabled Whether to queue the frames (pending frames are written when disabling it)
+        /// @param framesPerUpdate Maximum number of frames written by an Update (0 writes every pending frame)
+        void SetOutboundQueue(bool enabled, size_t framesPerUpdate = 0);
+
+        /// Write pending frames of the outbound queue, higher priorities first
+        /// @param maxFrames Maximum number of frames to write (0 writes every pending frame)
+        /// @return The number of frames written
+        size_t Flush(size_t maxFrames = 0);
+
+        /// Get the outbound queue of a priority class with its metrics
+        /// @param priority The priority class
+        /// @return The queue of the class (the normal one if the class is invalid)
+        const LogoLane& GetLane(LogoPriority priority);
+        void _clients_received();
+        int _result_received(const char* sender, const char* message);
+        void _write(const char* msg, size_t length);
+        void _dispatch(const char* sender, MessageTypeReceive messageType, const char* message);
+        int _raw_available();
+        size_t _raw_read(char* buffer, size_t length);
+        void _raw_write(const char* msg, size_t length);
+
         int Connected();
         String GetName();
         String GetServerName();
@@ -60,12 +172,55 @@ class LogoClient {
         size_t GetNumClients();
 };
 
-int LogoAvailable_CXX(LogoClient* logoClient);
-size_t LogoRead_CXX(LogoClient* logoClient, char* buffer, size_t length);
-void LogoWrite_CXX(LogoClient* logoClient, const char* msg, size_t length);
+/// Client using a transport policy, the transport's functions are called through a per-instance table and can be inlined
+/// The transport has to implement int Available(), size_t Read(char* buffer, size_t length) and void Write(const char* msg, size_t length)
+template<class TTransport>
+class BasicLogoClient : public LogoClient {
+    private:
+        static BasicLogoClient* FromData(LogoData* logoData) {
+            return static_cast<BasicLogoClient*>((LogoClient*)logoData->_logo_client);
+        }
+        static int _transport_available(LogoData* logoData) {
+            return FromData(logoData)->Transport.Available();
+        }
+        static size_t _transport_read(LogoData* logoData, char* buffer, size_t length) {
+            return FromData(logoData)->Transport.Read(buffer, length);
+        }
+        static void _transport_write(LogoData* logoData, const char* msg, size_t length) {
+            FromData(logoData)->Transport.Write(msg, length);
+        }
+        static const LogoTransport Table;
+    public:
+        TTransport Transport;
+
+        explicit BasicLogoClient(char* name, size_t bufferSize = 1024) : LogoClient(&Table, name, bufferSize) {
+        }
+        explicit BasicLogoClient(String name, size_t bufferSize = 1024) : LogoClient(&Table, name, bufferSize) {
+        }
+        BasicLogoClient(char* name, void (*onMessage)(LogoClient*, const char*, MessageTypeReceive, const char*), size_t bufferSize = 1024) : LogoClient(&Table, name, onMessage, bufferSize) {
+        }
+        BasicLogoClient(String name, void (*onMessage)(LogoClient*, const String&, MessageTypeReceive, const String&), size_t bufferSize = 1024) : LogoClient(&Table, name, onMessage, bufferSize) {
+        }
+};
+
+template<class TTransport>
+const LogoTransport BasicLogoClient<TTransport>::Table = {
+    BasicLogoClient<TTransport>::_transport_available,
+    BasicLogoClient<TTransport>::_transport_read,
+    BasicLogoClient<TTransport>::_transport_write
+};
+
+/// To be implemented by the user when deriving from LogoClient directly instead of BasicLogoClient, nothing is read or written if they aren't
+LOGO_WEAK int LogoAvailable_CXX(LogoClient* logoClient);
+LOGO_WEAK size_t LogoRead_CXX(LogoClient* logoClient, char* buffer, size_t length);
+LOGO_WEAK void LogoWrite_CXX(LogoClient* logoClient, const char* msg, size_t length);
+
+/// Transport calling the global LogoX_CXX hooks, for clients deriving from LogoClient directly
+extern const LogoTransport LogoHooksTransport;
 
 char* _copy_str(const String& str);
 void _message_proxy(LogoData* logoData, const char* sender, MessageTypeReceive messageType, const char* message);
+void _clients_proxy(LogoData* logoData);
 
 String logo_to_string_CXX(const String& str);
 
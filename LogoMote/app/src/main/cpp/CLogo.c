@@ -23,9 +23,35 @@ void logo_init(LogoData* logoData) {
     logoData->Clients = NULL;
     logoData->NumClients = 0;
     logoData->OnMessage = NULL;
+    logoData->OnClients = NULL;
+    logoData->Transport = NULL;
+    logoData->_logo_read_buffer = NULL;
+    logoData->_logo_read_length = 0;
     logoData->_logo_client = NULL;
 }
 
+int _logo_available(LogoData* logoData) {
+    //An unimplemented weak hook resolves to NULL
+    if(logoData->Transport == NULL)
+        return LogoAvailable_C != NULL ? LogoAvailable_C(logoData) : 0;
+    return logoData->Transport->Available(logoData);
+}
+
+size_t _logo_read(LogoData* logoData, char* buffer, size_t length) {
+    if(logoData->Transport == NULL)
+        return LogoRead_C != NULL ? LogoRead_C(logoData, buffer, length) : 0;
+    return logoData->Transport->Read(logoData, buffer, length);
+}
+
+void _logo_write(LogoData* logoData, const char* msg, size_t length) {
+    if(logoData->Transport == NULL) {
+        if(LogoWrite_C != NULL)
+            LogoWrite_C(logoData, msg, length);
+        return;
+    }
+    logoData->Transport->Write(logoData, msg, length);
+}
+
 void logo_free(LogoData* logoData) {
     logo_reset(logoData);
     if(logoData->OriginalName != NULL)
@@ -60,11 +86,13 @@ size_t _logo_encode_number(size_t n, char* buffer) {
     return size;
 }
 
-size_t _logo_read_number(size_t* n, char* data) {
+size_t _logo_read_number(size_t* n, char* data, size_t length) {
     size_t result = 0;
     char c = 48;
     size_t i = 0;
     while(c != LOGO_SEPARATOR) {
+        if(i >= length)
+            return 0;
         result = result * 10 + c - 48;
         c = data[i++];
     }
@@ -72,10 +100,12 @@ size_t _logo_read_number(size_t* n, char* data) {
     return i;
 }
 
-size_t _logo_next_part(char* data) {
+size_t _logo_next_part(char* data, size_t length) {
     char c = 0;
     size_t i = 0;
     while(c != LOGO_SEPARATOR) {
+        if(i >= length)
+            return 0;
         c = data[i++];
     }
     return i;
@@ -121,12 +151,74 @@ void logo_send_raw(LogoData* logoData, MessageTypeSend messageType, const char**
     for(size_t i = 0; i < partsDataIndex; i++)
         data[dataIndex++] = partsData[i];
 
-    LogoWrite_C(logoData, data, dataIndex);
+    _logo_write(logoData, data, dataIndex);
     
     free(data);
     free(partsData);
 }
 
+size_t logo_max_message_length(LogoData* logoData, const char** clients, size_t numClients) {
+    char number[20];
+    //Separator, type, number of parts and separator, then <length>!<part> for the name and every client
+    size_t header = 3 + _logo_encode_number(numClients + 1, number);
+    for(size_t i = 0; i <= numClients; i++) {
+        size_t partLength = strlen(i == 0 ? logoData->Name : clients[i-1]);
+        header += _logo_encode_number(partLength, number) + 1 + partLength;
+    }
+    if(header >= logoData->BufferSize)
+        return 0;
+    return logoData->BufferSize - header;
+}
+
+int logo_route_init(LogoData* logoData, LogoRoute* route, MessageTypeSend messageType, const char** clients, size_t numClients) {
+    route->Header = NULL;
+    route->HeaderLength = 0;
+    if(logoData->Name == NULL || logo_max_message_length(logoData, clients, numClients) <= 4)
+        return 0;
+    char* header = (char*)malloc(logoData->BufferSize * sizeof(char));
+    size_t headerIndex = 0;
+    header[headerIndex++] = LOGO_SEPARATOR;
+    header[headerIndex++] = messageType;
+    headerIndex += _logo_encode_number(numClients + 1, header + headerIndex);
+    header[headerIndex++] = LOGO_SEPARATOR;
+    for(size_t i = 0; i <= numClients; i++) {
+        const char* part = i == 0 ? logoData->Name : clients[i-1];
+        size_t partLength = strlen(part);
+        headerIndex += _logo_encode_number(partLength, header + headerIndex);
+        header[headerIndex++] = LOGO_SEPARATOR;
+        memcpy(header + headerIndex, part, partLength);
+        headerIndex += partLength;
+    }
+    if(messageType == SND_RESULT) {
+        memcpy(header + headerIndex, "OK: ", 4);
+        headerIndex += 4;
+    }
+    route->Header = header;
+    route->HeaderLength = headerIndex;
+    return 1;
+}
+
+void logo_route_free(LogoRoute* route) {
+    if(route->Header != NULL)
+        free(route->Header);
+    route->Header = NULL;
+    route->HeaderLength = 0;
+}
+
+size_t logo_send_routed(LogoData* logoData, const LogoRoute* route, const char* message, size_t length, char* buffer) {
+    if(route->Header == NULL || route->HeaderLength + length > logoData->BufferSize)
+        return 0;
+    buffer[0] = LOGO_START;
+    size_t dataIndex = 1;
+    dataIndex += _logo_encode_number(route->HeaderLength + length - 1, buffer + dataIndex);
+    memcpy(buffer + dataIndex, route->Header, route->HeaderLength);
+    dataIndex += route->HeaderLength;
+    memcpy(buffer + dataIndex, message, length);
+    dataIndex += length;
+    _logo_write(logoData, buffer, dataIndex);
+    return dataIndex;
+}
+
 void logo_send_message(LogoData* logoData, MessageTypeSend messageType, const char* message, const char** clients, size_t numClients) {
     char** _clients = (char**)malloc(++numClients * sizeof(char*));
     
@@ -157,6 +249,10 @@ void logo_reset(LogoData* logoData) {
     logoData->Name = NULL;
     logoData->Connected = 0;
     logoData->NumClients = 0;
+    if(logoData->_logo_read_buffer != NULL)
+        free(logoData->_logo_read_buffer);
+    logoData->_logo_read_buffer = NULL;
+    logoData->_logo_read_length = 0;
 }
 
 void logo_join(LogoData* logoData) {
@@ -171,79 +267,125 @@ void logo_update_clients(LogoData* logoData) {
 }
 
 void logo_update(LogoData* logoData) {
-    if(!LogoAvailable_C(logoData))
-        return;
-    char* data = (char*)malloc(logoData->BufferSize * sizeof(char));
-    LogoRead_C(logoData, data, logoData->BufferSize);
-    if(data[0] != LOGO_START)
+    if(!_logo_available(logoData))
         return;
+    if(logoData->_logo_read_buffer == NULL) {
+        logoData->_logo_read_buffer = (char*)malloc(logoData->BufferSize * sizeof(char));
+        logoData->_logo_read_length = 0;
+    }
+    char* data = logoData->_logo_read_buffer;
+    size_t available = logoData->_logo_read_length;
+    available += _logo_read(logoData, data + available, logoData->BufferSize - available);
+
+    //A read can contain more frames, process every complete one and keep the rest for the next read
+    size_t offset = 0;
+    while(offset < available) {
+        if(data[offset] != LOGO_START) {
+            offset++;
+            continue;
+        }
+        size_t frameLength = _logo_process_frame(logoData, data + offset, available - offset);
+        if(frameLength == 0)
+            break;
+        offset += frameLength;
+    }
+    available -= offset;
+    //A frame that doesn't fit into the buffer can never be completed, discard it
+    if(available == logoData->BufferSize)
+        available = 0;
+    if(available > 0 && offset > 0)
+        memmove(data, data + offset, available);
+    logoData->_logo_read_length = available;
+}
+
+size_t _logo_process_frame(LogoData* logoData, char* data, size_t available) {
     size_t length = 0;
-    size_t dataIndex = _logo_read_number(&length, data + 1) + 1;
+    size_t partLenght = _logo_read_number(&length, data + 1, available - 1);
+    if(partLenght == 0)
+        return 0;
+    size_t dataIndex = partLenght + 1;
+    const size_t frameLength = dataIndex + length;
+    //Can never be completed, skip the start byte to find the next frame
+    if(frameLength > logoData->BufferSize)
+        return 1;
+    if(frameLength > available)
+        return 0;
+    if(length == 0)
+        return frameLength;
     MessageTypeReceive messageType = (MessageTypeReceive)data[dataIndex++];
-    length--;
-    size_t partLenght;
     switch(messageType) {
         case RCV_JOINED: {     //Response to a join command, data contains the given name
-            partLenght = _logo_next_part(data + dataIndex);
-            length -= partLenght;
+            partLenght = _logo_next_part(data + dataIndex, frameLength - dataIndex);
+            if(partLenght == 0)
+                break;
             dataIndex += partLenght;
+            length = frameLength - dataIndex;
+            if(logoData->Name != NULL)
+                free(logoData->Name);
             logoData->Name = (char*)malloc((length + 1) * sizeof(char));
             for(size_t i = 0; i < length; i++) {
                 logoData->Name[i] = data[dataIndex++];
             }
             logoData->Name[length] = 0;
-            length = 0;
             logo_update_clients(logoData);
             break;   
         }
         case RCV_CLIENTS: {     //Response to a client query, data contains the number and names of the connected clients
-            _logo_free_clients(logoData);
-            partLenght = _logo_read_number(&logoData->NumClients, data + dataIndex);
-            length -= partLenght;
+            size_t numClients;
+            partLenght = _logo_read_number(&numClients, data + dataIndex, frameLength - dataIndex);
+            if(partLenght == 0)
+                break;
             dataIndex += partLenght;
-            logoData->Clients = (char**)malloc(logoData->NumClients * sizeof(char*));
-            for(uint i = 0; i < logoData->NumClients; i++) {
+            _logo_free_clients(logoData);
+            logoData->Clients = (char**)malloc(numClients * sizeof(char*));
+            logoData->NumClients = 0;
+            for(size_t i = 0; i < numClients; i++) {
                 size_t nameLength;
-                dataIndex += _logo_read_number(&nameLength, data + dataIndex);
+                partLenght = _logo_read_number(&nameLength, data + dataIndex, frameLength - dataIndex);
+                if(partLenght == 0 || nameLength > frameLength - dataIndex - partLenght)
+                    break;
+                dataIndex += partLenght;
                 logoData->Clients[i] = (char*)malloc((nameLength + 1) * sizeof(char));
-                for(uint j = 0; j < nameLength; j++) {
+                for(size_t j = 0; j < nameLength; j++) {
                     logoData->Clients[i][j] = data[dataIndex++];
                 }
                 logoData->Clients[i][nameLength] = 0;
+                logoData->NumClients++;
             }
             logoData->Connected = 1;
+            if(logoData->OnClients != NULL)
+                logoData->OnClients(logoData);
             break;
         }
         case RCV_MESSAGE:       //Standard message, command or procedure result, data contains the sender and message, call the OnMessage delegate
         case RCV_COMMAND:
         case RCV_RESULT: {
             size_t senderLength;
-            partLenght = _logo_next_part(data + dataIndex);
-            length -= partLenght;
+            partLenght = _logo_next_part(data + dataIndex, frameLength - dataIndex);
+            if(partLenght == 0)
+                break;
 
             //Read the sender name
             dataIndex += partLenght;
-            partLenght = _logo_read_number(&senderLength, data + dataIndex);
-            length -= partLenght;
+            partLenght = _logo_read_number(&senderLength, data + dataIndex, frameLength - dataIndex);
+            if(partLenght == 0 || senderLength > frameLength - dataIndex - partLenght)
+                break;
             dataIndex += partLenght;
             char* sender = (char*)malloc((senderLength + 1) * sizeof(char));
-            for(uint i = 0; i < senderLength; i++) {
+            for(size_t i = 0; i < senderLength; i++) {
                 sender[i] = data[dataIndex++];
-                length--;
             }
             sender[senderLength] = 0;
 
             //Procedure results tart with "OK: ", discard it
-            if(messageType == RCV_RESULT) {
+            if(messageType == RCV_RESULT && frameLength - dataIndex >= 4)
                 dataIndex += 4;
-                length -= 4;
-            }
+            length = frameLength - dataIndex;
             char* message = (char*)malloc((length + 1) * sizeof(char));
             for(size_t i = 0; i < length; i++) {
                 message[i] = data[dataIndex++];
             }
             message[length] = 0;
-            length = 0;
 
             if(logoData->OnMessage != NULL)
                 logoData->OnMessage(logoData, sender, messageType, message);
@@ -256,7 +398,7 @@ void logo_update(LogoData* logoData) {
             break;
         }
     }
-    free(data);
+    return frameLength;
 }
 
 const char* logo_server(LogoData* logoData) {
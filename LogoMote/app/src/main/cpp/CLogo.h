@@ -10,6 +10,13 @@
 #define LOGO_START 0x07
 #define LOGO_SEPARATOR 0x21
 
+/// The global LogoAvailable_C/LogoRead_C/LogoWrite_C hooks are weak symbols, they only have to be implemented for LogoData without a Transport table
+#if defined(__GNUC__) || defined(__clang__)
+#define LOGO_WEAK __attribute__((weak))
+#else
+#define LOGO_WEAK
+#endif
+
 /// Enumeration of bytes to send to indicate the message type
 typedef enum MessageTypeSend {
     /// Standard message
@@ -38,6 +45,18 @@ typedef enum MessageTypeReceive {
     RCV_CLIENTS = 0x76
 } MessageTypeReceive;
 
+struct LogoData;
+
+/// Table of functions communicating with the server, can be different for every LogoData
+typedef struct LogoTransport {
+    /// Gets wether data is available to be read from the stream (0 if no bytes are available to be read, 1 otherwise)
+    int (*Available)(struct LogoData*);
+    /// Reads data from the stream into a buffer, returns the number of bytes read
+    size_t (*Read)(struct LogoData*, char*, size_t);
+    /// Write data to the stream
+    void (*Write)(struct LogoData*, const char*, size_t);
+} LogoTransport;
+
 /// Structure containing values required to communicate with the Imagine server
 typedef struct LogoData {
     char* OriginalName;     //Requested name
@@ -47,26 +66,55 @@ typedef struct LogoData {
     char** Clients;
     size_t NumClients;
     void (*OnMessage)(struct LogoData*, const char*, MessageTypeReceive, const char*);
+    void (*OnClients)(struct LogoData*);    //Called after the names of the connected clients were received
+    const LogoTransport* Transport;     //Functions to communicate with, the global hooks are used when NULL
+    char* _logo_read_buffer;    //Received bytes of an incomplete frame, completed by the next read
+    size_t _logo_read_length;
     void* _logo_client;     //C++ proxy - instance of LogoClient
 } LogoData;
 
+/// Precomputed frame header for sending messages to the same clients
+typedef struct LogoRoute {
+    char* Header;           //Separator, message type and the encoded parts
+    size_t HeaderLength;
+} LogoRoute;
+
 /// To be implemented by the user - Gets wether data is available to be read from the TCP stream
+/// Used for LogoData without a Transport table, nothing is read if it isn't implemented
 /// @param logoData Pointer to the LogoData instance
 /// @return 0 if no bytes are available to be read, 1 otherwise
-int LogoAvailable_C(LogoData* logoData);
+LOGO_WEAK int LogoAvailable_C(LogoData* logoData);
 
 /// To be implemented by the user - Reads data from the TCP stream into a buffer
 /// @param logoData Pointer to the LogoData instance
 /// @param buffer The buffer to read the data into
 /// @param length The length of the buffer
 /// @return The number of bytes read
-size_t LogoRead_C(LogoData* logoData, char* buffer, size_t length);
+LOGO_WEAK size_t LogoRead_C(LogoData* logoData, char* buffer, size_t length);
 
 /// To be implemented by the user - Write data to the TCP stream
 /// @param logoData Pointer to the LogoData instance
 /// @param msg The data to send
 /// @param length The length of the msg buffer
-void LogoWrite_C(LogoData* logoData, const char* msg, size_t length);
+LOGO_WEAK void LogoWrite_C(LogoData* logoData, const char* msg, size_t length);
+
+/// Gets wether data is available to be read, using the Transport table or the global hook
+/// @param logoData Pointer to the LogoData instance
+/// @return 0 if no bytes are available to be read, 1 otherwise
+int _logo_available(LogoData* logoData);
+
+/// Reads data into a buffer, using the Transport table or the global hook
+/// @param logoData Pointer to the LogoData instance
+/// @param buffer The buffer to read the data into
+/// @param length The length of the buffer
+/// @return The number of bytes read
+size_t _logo_read(LogoData* logoData, char* buffer, size_t length);
+
+/// Write data, using the Transport table or the global hook
+/// @param logoData Pointer to the LogoData instance
+/// @param msg The data to send
+/// @param length The length of the msg buffer
+void _logo_write(LogoData* logoData, const char* msg, size_t length);
 
 /// Create and initialize an instance of LogoData
 /// @param name Requested name of the client (null-terminated)
@@ -93,14 +141,16 @@ size_t _logo_encode_number(size_t n, char* buffer);
 
 /// Discard bytes until a separator
 /// @param data The pointer to read the bytes from
-/// @return The number of bytes discarded
-size_t _logo_next_part(char* data);
+/// @param length The number of bytes available in data
+/// @return The number of bytes discarded, 0 if there's no separator in data
+size_t _logo_next_part(char* data, size_t length);
 
 /// Read remaining bytes as continuous number
 /// @param n The pointer to read the number into
 /// @param data The pointer to read the bytes from
-/// @return The length of the number
-size_t _logo_read_number(size_t* n, char* data);
+/// @param length The number of bytes available in data
+/// @return The length of the number, 0 if there's no separator in data
+size_t _logo_read_number(size_t* n, char* data, size_t length);
 
 /// Reset the values of the LogoData instance to be able to reconnect
 /// @param logoData Pointer to the LogoData instance
@@ -114,6 +164,35 @@ void logo_reset(LogoData* logoData);
 /// @param append Null-terminated string to append to the end of the message
 void logo_send_raw(LogoData* logoData, MessageTypeSend messageType, const char** parts, size_t partsLength, const char* append);
 
+/// Get the longest message that fits into a frame sent to specific clients
+/// @param logoData Pointer to the LogoData instance
+/// @param clients Null-terminated strings representing the names of the clients to send the message to
+/// @param numClients The length of the clients buffer (number of clients)
+/// @return The maximum length of the message (0 if not even the header fits)
+size_t logo_max_message_length(LogoData* logoData, const char** clients, size_t numClients);
+
+/// Precompute the frame header of messages sent to specific clients
+/// @param logoData Pointer to the LogoData instance
+/// @param route Pointer to the route to initialize
+/// @param messageType The type of messages to be sent
+/// @param clients Null-terminated strings representing the names of the clients to send the messages to
+/// @param numClients The length of the clients buffer (number of clients)
+/// @return 1 on success, 0 if the header doesn't fit into a frame
+int logo_route_init(LogoData* logoData, LogoRoute* route, MessageTypeSend messageType, const char** clients, size_t numClients);
+
+/// Free the memory allocations of a route
+/// @param route Pointer to the route
+void logo_route_free(LogoRoute* route);
+
+/// Send a message through a precomputed route, without allocating memory
+/// @param logoData Pointer to the LogoData instance
+/// @param route Pointer to the route
+/// @param message The message (doesn't have to be null-terminated)
+/// @param length Length of the message
+/// @param buffer The buffer to build the frame in (size is at least BufferSize+8)
+/// @return The number of bytes written, 0 if the message doesn't fit into a frame
+size_t logo_send_routed(LogoData* logoData, const LogoRoute* route, const char* message, size_t length, char* buffer);
+
 /// Send a message to specific clients
 /// @param logoData Pointer to the LogoData instance
 /// @param messageType The type of message to be sent
@@ -137,6 +216,13 @@ void logo_join(LogoData* logoData);
 /// @param logoData Pointer to the LogoData instance
 void logo_update_clients(LogoData* logoData);
 
+/// Process a single frame received from the server
+/// @param logoData Pointer to the LogoData instance
+/// @param data The bytes of the frame, starting with LOGO_START
+/// @param available The number of bytes available in data
+/// @return The length of the frame (the next frame starts after it), 0 if the frame is incomplete
+size_t _logo_process_frame(LogoData* logoData, char* data, size_t available);
+
 /// Read incoming messages from the server
 /// @param logoData Pointer to the LogoData instance
 void logo_update(LogoData* logoData);
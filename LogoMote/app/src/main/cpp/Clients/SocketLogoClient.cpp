@@ -8,26 +8,7 @@
 
 #include "SocketLogoClient.hpp"
 
-int LogoAvailable_CXX(LogoClient* logoClient)
-{
-    return ((SocketLogoClient*)logoClient)->_available();
-}
-
-size_t LogoRead_CXX(LogoClient* logoClient, char* buffer, size_t length)
-{
-    return ((SocketLogoClient*)logoClient)->_read(buffer, length);
-}
-
-void LogoWrite_CXX(LogoClient* logoClient, const char* msg, size_t length)
-{
-    return ((SocketLogoClient*)logoClient)->_write(msg, length);
-}
-
-SocketLogoClient::~SocketLogoClient() {
-    this->Stop();
-}
-
-int SocketLogoClient::Connect(const char* host, uint16_t port) {
+int SocketTransport::Open(const char* host, uint16_t port) {
     struct sockaddr_in address;
     this->SockFD = socket(AF_INET, SOCK_STREAM, 0);
     if(this->SockFD == -1)
@@ -38,34 +19,39 @@ int SocketLogoClient::Connect(const char* host, uint16_t port) {
     address.sin_port = htons(port);
     if(connect(this->SockFD, (struct sockaddr*)&address, sizeof(address)) != 0)
         return 0;
-    this->Join();
     return 1;
 }
 
-int SocketLogoClient::Connect(const String& host, uint16_t port) {
-    return this->Connect(host.c_str(), port);
-}
-
-void SocketLogoClient::Stop() {
+void SocketTransport::Close() {
+    //Stop is called by both Disconnect and the destructor
+    if(this->SockFD == -1)
+        return;
     shutdown(this->SockFD, SHUT_RDWR);
-    if(this->_available())
+    if(this->Available())
     {
         char _buffer[this->BytesAvailable];
         recv(this->SockFD, _buffer, this->BytesAvailable, 0);
     }
     close(this->SockFD);
-    this->Reset();
+    this->SockFD = -1;
 }
 
-int SocketLogoClient::_available() {
-    ioctl(this->SockFD, FIONREAD, &this->BytesAvailable);
-    return this->BytesAvailable > 0;
+SocketLogoClient::~SocketLogoClient() {
+    this->Stop();
 }
 
-size_t SocketLogoClient::_read(char* buffer, size_t length) {
-    return read(this->SockFD, buffer, std::min(length, (size_t)this->BytesAvailable));
+int SocketLogoClient::Connect(const char* host, uint16_t port) {
+    if(!this->Transport.Open(host, port))
+        return 0;
+    this->Join();
+    return 1;
 }
 
-void SocketLogoClient::_write(const char* msg, size_t length) {
-    write(this->SockFD, msg, length);
+int SocketLogoClient::Connect(const String& host, uint16_t port) {
+    return this->Connect(host.c_str(), port);
+}
+
+void SocketLogoClient::Stop() {
+    this->Transport.Close();
+    this->Reset();
 }
@@ -1,21 +1,42 @@
 #ifndef SOCKETLOGOCLIENT_HPP
 #define SOCKETLOGOCLIENT_HPP
 
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <algorithm>
+
 #include "../CLogo++.hpp"
 
-class SocketLogoClient : public LogoClient {
-    private:
-        int SockFD;
-        int BytesAvailable;
+/// Transport communicating through a TCP socket
+class SocketTransport {
+    public:
+        int SockFD = -1;
+        int BytesAvailable = 0;
+
+        int Open(const char* host, uint16_t port);
+        void Close();
+
+        int Available() {
+            ioctl(this->SockFD, FIONREAD, &this->BytesAvailable);
+            return this->BytesAvailable > 0;
+        }
+
+        size_t Read(char* buffer, size_t length) {
+            return read(this->SockFD, buffer, std::min(length, (size_t)this->BytesAvailable));
+        }
+
+        void Write(const char* msg, size_t length) {
+            write(this->SockFD, msg, length);
+        }
+};
+
+class SocketLogoClient : public BasicLogoClient<SocketTransport> {
     public:
-        using LogoClient::LogoClient;
+        using BasicLogoClient::BasicLogoClient;
         ~SocketLogoClient();
         int Connect(const char* host, uint16_t port = 51);
         int Connect(const String& host, uint16_t port = 51);
         void Stop();
-        int _available();
-        size_t _read(char* buffer, size_t length);
-        void _write(const char* msg, size_t length);
 };
 
 #endif
@@ -0,0 +1,124 @@
+#ifndef ARDUINO
+#include "LogoDispatcher.hpp"
+
+#include <functional>
+
+LogoDispatcher::LogoDispatcher(size_t numWorkers, size_t capacity, LogoOverflow overflow) {
+    this->NumWorkers = numWorkers > 0 ? numWorkers : 1;
+    this->Capacity = capacity > 0 ? capacity : 1;
+    this->Overflow = overflow;
+    this->Workers = new Worker[this->NumWorkers];
+    for(size_t i = 0; i < this->NumWorkers; i++) {
+        Worker* worker = &this->Workers[i];
+        worker->Thread = std::thread(&LogoDispatcher::Run, this, worker);
+    }
+}
+
+LogoDispatcher::~LogoDispatcher() {
+    this->Stop();
+    delete[] this->Workers;
+}
+
+void LogoDispatcher::Run(Worker* worker) {
+    for(;;) {
+        std::unique_lock<std::mutex> lock(worker->Mutex);
+        worker->Posted.wait(lock, [this, worker] { return this->Stopping || !worker->Queue.empty(); });
+        if(worker->Queue.empty())
+            return;
+        Message message = std::move(worker->Queue.front());
+        worker->Queue.pop_front();
+        worker->Current = message.Client;
+        lock.unlock();
+        worker->Taken.notify_one();
+        message.Client->_dispatch(message.Sender.c_str(), message.MessageType, message.Text.c_str());
+        this->NumDispatched++;
+        lock.lock();
+        worker->Current = NULL;
+        lock.unlock();
+        worker->Idle.notify_all();
+    }
+}
+
+void LogoDispatcher::Post(LogoClient* client, const char* sender, MessageTypeReceive messageType, const char* message) {
+    Worker* worker = &this->Workers[std::hash<std::string>()(sender) % this->NumWorkers];
+    {
+        std::unique_lock<std::mutex> lock(worker->Mutex);
+        if(this->Stopping) {
+            this->NumDropped++;
+            return;
+        }
+        if(worker->Queue.size() >= this->Capacity) {
+            switch(this->Overflow) {
+                case OVERFLOW_BLOCK:
+                    worker->Taken.wait(lock, [this, worker] { return this->Stopping || worker->Queue.size() < this->Capacity; });
+                    if(this->Stopping) {
+                        this->NumDropped++;
+                        return;
+                    }
+                    break;
+                case OVERFLOW_DROP_OLDEST:
+                    worker->Queue.pop_front();
+                    this->NumDropped++;
+                    break;
+                case OVERFLOW_DROP_NEWEST:
+                    this->NumDropped++;
+                    return;
+            }
+        }
+        worker->Queue.push_back(Message{client, sender, messageType, message});
+    }
+    worker->Posted.notify_one();
+}
+
+void LogoDispatcher::Drain(LogoClient* client) {
+    for(size_t i = 0; i < this->NumWorkers; i++) {
+        Worker* worker = &this->Workers[i];
+        {
+            std::unique_lock<std::mutex> lock(worker->Mutex);
+            for(auto it = worker->Queue.begin(); it != worker->Queue.end();) {
+                if(it->Client != client) {
+                    it++;
+                    continue;
+                }
+                it = worker->Queue.erase(it);
+                this->NumDropped++;
+            }
+            //An event destroying its own client can't wait for itself
+            if(worker->Thread.get_id() != std::this_thread::get_id())
+                worker->Idle.wait(lock, [worker, client] { return worker->Current != client; });
+        }
+        worker->Taken.notify_all();
+    }
+}
+
+void LogoDispatcher::Stop() {
+    for(size_t i = 0; i < this->NumWorkers; i++) {
+        std::lock_guard<std::mutex> lock(this->Workers[i].Mutex);
+        this->Stopping = true;
+    }
+    for(size_t i = 0; i < this->NumWorkers; i++) {
+        Worker* worker = &this->Workers[i];
+        worker->Posted.notify_all();
+        worker->Taken.notify_all();
+        if(worker->Thread.joinable())
+            worker->Thread.join();
+    }
+}
+
+size_t LogoDispatcher::Dispatched() const {
+    return this->NumDispatched;
+}
+
+size_t LogoDispatcher::Dropped() const {
+    return this->NumDropped;
+}
+
+size_t LogoDispatcher::Pending() {
+    size_t pending = 0;
+    for(size_t i = 0; i < this->NumWorkers; i++) {
+        std::lock_guard<std::mutex> lock(this->Workers[i].Mutex);
+        pending += this->Workers[i].Queue.size();
+    }
+    return pending;
+}
+#endif
@@ -0,0 +1,85 @@
+#ifndef LOGODISPATCHER_HPP
+#define LOGODISPATCHER_HPP
+
+#ifndef ARDUINO
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "CLogo++.hpp"
+
+/// What to do with a message when the queue of its worker is full
+enum LogoOverflow {
+    /// Wait in Update until the worker takes a message
+    OVERFLOW_BLOCK,
+    /// Discard the oldest queued message
+    OVERFLOW_DROP_OLDEST,
+    /// Discard the incoming message
+    OVERFLOW_DROP_NEWEST
+};
+
+/// Calls the OnMessage events of clients on a pool of worker threads
+/// Messages of the same sender are handled by the same worker in the order they were received, different senders are handled in parallel
+/// The events run on the worker threads, using the client from them has to be synchronized with Update
+class LogoDispatcher {
+    private:
+        struct Message {
+            LogoClient* Client;
+            std::string Sender;
+            MessageTypeReceive MessageType;
+            std::string Text;
+        };
+        struct Worker {
+            std::deque<Message> Queue;
+            std::mutex Mutex;
+            std::condition_variable Posted;
+            std::condition_variable Taken;
+            std::condition_variable Idle;
+            LogoClient* Current = NULL;
+            std::thread Thread;
+        };
+        Worker* Workers;
+        size_t NumWorkers;
+        size_t Capacity;
+        LogoOverflow Overflow;
+        std::atomic<bool> Stopping{false};
+        std::atomic<size_t> NumDispatched{0};
+        std::atomic<size_t> NumDropped{0};
+
+        void Run(Worker* worker);
+    public:
+        /// @param numWorkers Number of worker threads (at least 1)
+        /// @param capacity Maximum number of queued messages per worker (at least 1)
+        /// @param overflow What to do when the queue of a worker is full
+        explicit LogoDispatcher(size_t numWorkers = 4, size_t capacity = 256, LogoOverflow overflow = OVERFLOW_BLOCK);
+        LogoDispatcher(const LogoDispatcher&) = delete;
+        LogoDispatcher& operator=(const LogoDispatcher&) = delete;
+        ~LogoDispatcher();
+
+        /// Queue a message for the worker of its sender
+        /// @param client The client that received the message
+        /// @param sender Null-terminated name of the sender
+        /// @param messageType The type of the message
+        /// @param message Null-terminated message
+        void Post(LogoClient* client, const char* sender, MessageTypeReceive messageType, const char* message);
+
+        /// Discard the queued messages of a client and wait until its running events return, called by the client when it's reset or destroyed
+        /// @param client The client whose messages to discard
+        void Drain(LogoClient* client);
+
+        /// Handle the queued messages and stop the workers, later messages are dropped
+        void Stop();
+
+        /// @return Number of messages handled
+        size_t Dispatched() const;
+        /// @return Number of messages discarded because of a full queue or after stopping
+        size_t Dropped() const;
+        /// @return Number of messages waiting in the queues
+        size_t Pending();
+};
+#endif
+
+#endif
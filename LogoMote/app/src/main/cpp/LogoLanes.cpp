@@ -0,0 +1,53 @@
+#include "LogoLanes.hpp"
+
+#ifndef ARDUINO
+#include <cstdlib>
+#include <cstring>
+#else
+#include <Arduino.h>
+#endif
+
+char* LogoFrame::Bytes() {
+    return (char*)(this + 1);
+}
+
+LogoLane::~LogoLane() {
+    this->Clear();
+}
+
+LogoFrame* LogoLane::Push(const char* msg, size_t length) {
+    auto frame = (LogoFrame*)malloc(sizeof(LogoFrame) + length);
+    if(frame == NULL)
+        return NULL;
+    frame->Next = NULL;
+    frame->Queued = logo_micros();
+    frame->Length = length;
+    frame->Results = 0;
+    frame->Probe = false;
+    frame->MirrorQuery = false;
+    frame->CommandLength = 0;
+    memcpy(frame->Bytes(), msg, length);
+    if(this->Tail == NULL)
+        this->Head = frame;
+    else this->Tail->Next = frame;
+    this->Tail = frame;
+    if(++this->Depth > this->MaxDepth)
+        this->MaxDepth = this->Depth;
+    return frame;
+}
+
+LogoFrame* LogoLane::Pop() {
+    LogoFrame* frame = this->Head;
+    if(frame == NULL)
+        return NULL;
+    this->Head = frame->Next;
+    if(this->Head == NULL)
+        this->Tail = NULL;
+    this->Depth--;
+    return frame;
+}
+
+void LogoLane::Clear() {
+    while(this->Head != NULL)
+        free(this->Pop());
+}
@@ -0,0 +1,78 @@
+#ifndef LOGOLANES_HPP
+#define LOGOLANES_HPP
+
+#ifndef ARDUINO
+#include <cstddef>
+#else
+#include <Arduino.h>
+#endif
+
+#include "LogoLatency.hpp"
+
+/// Priority classes of the outbound queue, frames of a higher class are written first
+enum LogoPriority {
+    /// Control commands (pen toggle, stop), overtake everything else
+    PRIORITY_HIGH,
+    /// Default class
+    PRIORITY_NORMAL,
+    /// Commands replacing the previous state (e.g. movement), only the newest pending frame is kept
+    PRIORITY_COALESCE,
+    /// Number of classes
+    LOGO_PRIORITIES
+};
+
+/// A frame waiting in the outbound queue, followed by its bytes
+struct LogoFrame {
+    LogoFrame* Next;
+    /// Timestamp of queueing in microseconds
+    unsigned long Queued;
+    size_t Length;
+    /// Number of server results the frame is expected to produce
+    size_t Results;
+    /// Whether the frame is a round trip probe
+    bool Probe;
+    /// Whether the frame is the state query of the turtle mirror
+    bool MirrorQuery;
+    /// Length of the command at the end of the frame to apply to the mirror once written (0 if none)
+    size_t CommandLength;
+
+    char* Bytes();
+};
+
+/// FIFO queue of frames of a priority class, with its metrics
+class LogoLane {
+    private:
+        LogoFrame* Head = NULL;
+        LogoFrame* Tail = NULL;
+    public:
+        /// Number of frames waiting
+        size_t Depth = 0;
+        /// Highest number of frames waiting at once
+        size_t MaxDepth = 0;
+        /// Number of frames written
+        size_t Sent = 0;
+        /// Number of frames replaced by a newer one before being written
+        size_t Coalesced = 0;
+        /// Time the frames spent waiting before being written
+        LatencyHistogram Latency;
+
+        LogoLane() = default;
+        LogoLane(const LogoLane&) = delete;
+        LogoLane& operator=(const LogoLane&) = delete;
+        ~LogoLane();
+
+        /// Copy a frame to the end of the queue
+        /// @param msg The bytes of the frame
+        /// @param length The length of the msg buffer
+        /// @return The queued frame (NULL if the allocation failed)
+        LogoFrame* Push(const char* msg, size_t length);
+
+        /// Remove the first frame of the queue, it has to be freed using free
+        /// @return The removed frame (NULL if the queue is empty)
+        LogoFrame* Pop();
+
+        /// Free every waiting frame
+        void Clear();
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "LogoLatency.hpp"
+
+#ifndef ARDUINO
+#include <chrono>
+#else
+#include <Arduino.h>
+#endif
+
+LatencyHistogram::LatencyHistogram() {
+    this->Clear();
+}
+
+size_t LatencyHistogram::BucketOf(unsigned long micros) {
+    size_t bucket = 0;
+    while(micros > 1 && bucket < LOGO_LATENCY_BUCKETS - 1) {
+        micros >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void LatencyHistogram::Add(unsigned long micros) {
+    if(this->NumSamples == LOGO_LATENCY_WINDOW) {
+        unsigned long evicted = this->Samples[this->Next];
+        this->Buckets[BucketOf(evicted)]--;
+        this->Sum -= evicted;
+    }
+    else this->NumSamples++;
+    this->Samples[this->Next] = micros;
+    this->Next = (this->Next + 1) % LOGO_LATENCY_WINDOW;
+    this->Buckets[BucketOf(micros)]++;
+    this->Sum += micros;
+}
+
+void LatencyHistogram::Clear() {
+    for(size_t i = 0; i < LOGO_LATENCY_BUCKETS; i++)
+        this->Buckets[i] = 0;
+    this->NumSamples = 0;
+    this->Next = 0;
+    this->Sum = 0;
+}
+
+size_t LatencyHistogram::Count() const {
+    return this->NumSamples;
+}
+
+unsigned long LatencyHistogram::Last() const {
+    if(this->NumSamples == 0)
+        return 0;
+    return this->Samples[(this->Next + LOGO_LATENCY_WINDOW - 1) % LOGO_LATENCY_WINDOW];
+}
+
+unsigned long LatencyHistogram::Min() const {
+    unsigned long result = 0;
+    for(size_t i = 0; i < this->NumSamples; i++) {
+        if(i == 0 || this->Samples[i] < result)
+            result = this->Samples[i];
+    }
+    return result;
+}
+
+unsigned long LatencyHistogram::Max() const {
+    unsigned long result = 0;
+    for(size_t i = 0; i < this->NumSamples; i++) {
+        if(this->Samples[i] > result)
+            result = this->Samples[i];
+    }
+    return result;
+}
+
+unsigned long LatencyHistogram::Mean() const {
+    if(this->NumSamples == 0)
+        return 0;
+    return this->Sum / this->NumSamples;
+}
+
+unsigned long LatencyHistogram::Percentile(double percentile) const {
+    if(this->NumSamples == 0)
+        return 0;
+    size_t rank = (size_t)(percentile / 100 * this->NumSamples + 0.5);
+    if(rank == 0)
+        rank = 1;
+    if(rank > this->NumSamples)
+        rank = this->NumSamples;
+    size_t seen = 0;
+    for(size_t i = 0; i < LOGO_LATENCY_BUCKETS - 1; i++) {
+        seen += this->Buckets[i];
+        if(seen >= rank)
+            return (2UL << i) - 1;
+    }
+    return this->Max();
+}
+
+size_t LatencyHistogram::Bucket(size_t bucket) const {
+    if(bucket >= LOGO_LATENCY_BUCKETS)
+        return 0;
+    return this->Buckets[bucket];
+}
+
+unsigned long logo_micros() {
+#ifndef ARDUINO
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return micros();
+#endif
+}
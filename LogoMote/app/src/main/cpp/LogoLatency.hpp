@@ -0,0 +1,55 @@
+#ifndef LOGOLATENCY_HPP
+#define LOGOLATENCY_HPP
+
+#ifndef ARDUINO
+#include <cstddef>
+#else
+#include <Arduino.h>
+#endif
+
+/// Number of most recent samples a LatencyHistogram keeps
+#define LOGO_LATENCY_WINDOW 64
+/// Number of power of two buckets (the last one covers everything above 2^30 microseconds)
+#define LOGO_LATENCY_BUCKETS 32
+
+/// Rolling histogram of latencies in microseconds, keeping the last LOGO_LATENCY_WINDOW samples
+class LatencyHistogram {
+    private:
+        unsigned long Samples[LOGO_LATENCY_WINDOW];
+        size_t Buckets[LOGO_LATENCY_BUCKETS];
+        size_t NumSamples;
+        size_t Next;
+        unsigned long Sum;
+        static size_t BucketOf(unsigned long micros);
+    public:
+        LatencyHistogram();
+
+        /// Add a sample, evicting the oldest one when the window is full
+        /// @param micros The latency in microseconds
+        void Add(unsigned long micros);
+        void Clear();
+
+        /// @return The number of samples in the window
+        size_t Count() const;
+        /// @return The most recent sample (0 if there are none)
+        unsigned long Last() const;
+        unsigned long Min() const;
+        unsigned long Max() const;
+        unsigned long Mean() const;
+
+        /// Get an upper bound of a percentile of the samples in the window
+        /// @param percentile The percentile to get (0-100)
+        /// @return The upper bound of the bucket containing the percentile (0 if there are no samples)
+        unsigned long Percentile(double percentile) const;
+
+        /// Get the number of samples in a bucket
+        /// @param bucket Index of the bucket, covering [2^bucket, 2^(bucket+1)) microseconds (bucket 0 also contains 0)
+        /// @return The number of samples in the bucket
+        size_t Bucket(size_t bucket) const;
+};
+
+/// Get a monotonic timestamp
+/// @return The timestamp in microseconds
+unsigned long logo_micros();
+
+#endif
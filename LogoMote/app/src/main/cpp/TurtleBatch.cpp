@@ -0,0 +1,131 @@
+#include "TurtleBatch.hpp"
+
+#ifndef ARDUINO
+#include <cstdlib>
+#include <cstring>
+#else
+#include <Arduino.h>
+#endif
+
+TurtleBatch::~TurtleBatch() {
+    this->Clear();
+    free(this->Entries);
+}
+
+void TurtleBatch::Add(const String& turtle, const String& command) {
+    this->NumCommands++;
+    for(size_t i = 0; i < this->NumEntries; i++) {
+        Entry* entry = &this->Entries[i];
+        if(strcmp(entry->Turtle, turtle.c_str()) != 0)
+            continue;
+        //Join the commands of the turtle, so they stay in order when grouping the turtles
+        size_t length = strlen(entry->Command);
+        entry->Command = (char*)realloc(entry->Command, (length + command.length() + 2) * sizeof(char));
+        entry->Command[length] = ' ';
+        strcpy(entry->Command + length + 1, command.c_str());
+        return;
+    }
+    if(this->NumEntries == this->Capacity) {
+        this->Capacity = this->Capacity == 0 ? 16 : this->Capacity * 2;
+        this->Entries = (Entry*)realloc(this->Entries, this->Capacity * sizeof(Entry));
+    }
+    Entry* entry = &this->Entries[this->NumEntries++];
+    entry->Turtle = _copy_str(turtle);
+    entry->Command = _copy_str(command);
+    entry->Packed = false;
+}
+
+size_t TurtleBatch::Flush(LogoClient* client, LogoPriority priority) {
+    String server = client->GetServerName();
+    if(server.length() == 0)
+        return 0;
+    const size_t limit = client->MaxMessageLength(server);
+    String frame = "";
+    this->LastCommands = this->NumCommands;
+    this->LastFrames = 0;
+    this->LastBytes = 0;
+    this->LastDropped = 0;
+
+    for(size_t i = 0; i < this->NumEntries; i++) {
+        const char* command = this->Entries[i].Command;
+        //A group is split into more blocks when its turtles don't fit into a single frame
+        while(!this->Entries[i].Packed) {
+            String block = "ask [";
+            String close = "] [";
+            close += command;
+            close += "]";
+            size_t numTurtles = 0;
+            for(size_t j = i; j < this->NumEntries; j++) {
+                Entry* entry = &this->Entries[j];
+                if(entry->Packed || strcmp(entry->Command, command) != 0)
+                    continue;
+                size_t length = block.length() + (numTurtles > 0 ? 1 : 0) + strlen(entry->Turtle) + close.length();
+                if(length > limit) {
+                    if(numTurtles > 0)
+                        break;
+                    entry->Packed = true;
+                    this->LastDropped++;
+                    continue;
+                }
+                if(numTurtles++ > 0)
+                    block += " ";
+                block += entry->Turtle;
+                entry->Packed = true;
+            }
+            if(numTurtles == 0)
+                break;
+            block += close;
+
+            if(frame.length() > 0 && frame.length() + 1 + block.length() > limit) {
+                //The frames of a tick would replace each other in the coalescing lane
+                if(priority == PRIORITY_COALESCE)
+                    priority = PRIORITY_NORMAL;
+                client->SendMessage(SND_COMMAND, frame, server, priority);
+                this->LastFrames++;
+                this->LastBytes += frame.length();
+                frame = "";
+            }
+            if(frame.length() > 0)
+                frame += " ";
+            frame += block;
+        }
+    }
+    if(frame.length() > 0) {
+        client->SendMessage(SND_COMMAND, frame, server, priority);
+        this->LastFrames++;
+        this->LastBytes += frame.length();
+    }
+    this->Clear();
+    return this->LastFrames;
+}
+
+void TurtleBatch::Clear() {
+    for(size_t i = 0; i < this->NumEntries; i++) {
+        free(this->Entries[i].Turtle);
+        free(this->Entries[i].Command);
+    }
+    this->NumEntries = 0;
+    this->NumCommands = 0;
+}
+
+size_t TurtleBatch::Commands() const {
+    return this->LastCommands;
+}
+
+size_t TurtleBatch::Frames() const {
+    return this->LastFrames;
+}
+
+size_t TurtleBatch::Bytes() const {
+    return this->LastBytes;
+}
+
+size_t TurtleBatch::Dropped() const {
+    return this->LastDropped;
+}
+
+double TurtleBatch::CompressionRatio() const {
+    if(this->LastFrames == 0)
+        return 0;
+    return (double)this->LastCommands / this->LastFrames;
+}
@@ -0,0 +1,56 @@
+#ifndef TURTLEBATCH_HPP
+#define TURTLEBATCH_HPP
+
+#include "CLogo++.hpp"
+
+/// Collects the commands of many turtles for a tick and sends them to the server in as few frames as possible
+/// Turtles with the same commands share an ask [t1 t2 ...] block, the blocks are concatenated up to the frame size
+class TurtleBatch {
+    private:
+        struct Entry {
+            char* Turtle;
+            char* Command;
+            bool Packed;
+        };
+        Entry* Entries = NULL;
+        size_t NumEntries = 0;
+        size_t Capacity = 0;
+        size_t NumCommands = 0;
+
+        size_t LastCommands = 0;
+        size_t LastFrames = 0;
+        size_t LastBytes = 0;
+        size_t LastDropped = 0;
+    public:
+        TurtleBatch() = default;
+        TurtleBatch(const TurtleBatch&) = delete;
+        TurtleBatch& operator=(const TurtleBatch&) = delete;
+        ~TurtleBatch();
+
+        /// Add a command to the tick, commands of the same turtle are executed in the order they were added
+        /// @param turtle Name of the turtle (e.g. Page1't1)
+        /// @param command The command to execute
+        void Add(const String& turtle, const String& command);
+
+        /// Pack the commands of the tick and send them to the server
+        /// @param client The client to send the frames with
+        /// @param priority Priority of the frames, PRIORITY_COALESCE is only kept if the tick fits into a single frame (PRIORITY_NORMAL is used otherwise)
+        /// @return The number of frames sent
+        size_t Flush(LogoClient* client, LogoPriority priority = PRIORITY_NORMAL);
+
+        /// Discard the commands of the tick
+        void Clear();
+
+        /// @return Number of commands of the last flushed tick
+        size_t Commands() const;
+        /// @return Number of frames the last tick was sent in
+        size_t Frames() const;
+        /// @return Number of message bytes the last tick was sent in
+        size_t Bytes() const;
+        /// @return Number of turtles whose commands didn't fit into a frame in the last tick
+        size_t Dropped() const;
+        /// @return Commands per frame of the last tick (0 if nothing was sent)
+        double CompressionRatio() const;
+};
+
+#endif
@@ -0,0 +1,248 @@
+#include "TurtleMirror.hpp"
+
+#ifndef ARDUINO
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <Arduino.h>
+#endif
+
+#define TURTLE_TOKEN_SIZE 64
+
+/// Copy the next word or bracket into token
+/// @return Index after the token (token is empty at the end of str)
+static size_t _next_token(const char* str, size_t i, char* token) {
+    size_t length = 0;
+    while(str[i] == ' ' || str[i] == '\t' || str[i] == '\n' || str[i] == '\r')
+        i++;
+    if(str[i] == '[' || str[i] == ']')
+        token[length++] = str[i++];
+    else {
+        while(str[i] != 0 && str[i] != ' ' && str[i] != '\t' && str[i] != '\n' && str[i] != '\r' && str[i] != '[' && str[i] != ']') {
+            if(length < TURTLE_TOKEN_SIZE - 1)
+                token[length++] = str[i];
+            i++;
+        }
+    }
+    token[length] = 0;
+    return i;
+}
+
+/// Parse a literal number
+/// @return 1 on success, 0 if the token isn't a number
+static int _parse_number(const char* token, double* n) {
+    if(token[0] == 0)
+        return 0;
+    char* end;
+    *n = strtod(token, &end);
+    return *end == 0;
+}
+
+TurtleMirror::TurtleMirror(const String& turtle) : Turtle(turtle) {
+}
+
+void TurtleMirror::Move(double distance) {
+    const double radians = this->Dir * M_PI / 180;
+    this->PosX += distance * sin(radians);
+    this->PosY += distance * cos(radians);
+}
+
+void TurtleMirror::Turn(double angle) {
+    this->Dir = fmod(this->Dir + angle, 360);
+    if(this->Dir < 0)
+        this->Dir += 360;
+}
+
+void TurtleMirror::Apply(const char* command) {
+    char token[TURTLE_TOKEN_SIZE];
+    char arg[TURTLE_TOKEN_SIZE];
+    double n, n2;
+    size_t i = _next_token(command, 0, token);
+    //Commands sent after the query aren't included in its result
+    if(this->Recording) {
+        if(this->NumReplay < TURTLE_REPLAY_SIZE)
+            this->Replay[this->NumReplay++] = String(command);
+        else this->ReplayOverflow = true;
+    }
+    while(token[0] != 0) {
+        //Strip the owner of the primitive (Page1't1'forward), commands of other turtles end the parsing
+        const char* name = strrchr(token, '\'');
+        if(name != NULL) {
+            if((size_t)(name - token) != this->Turtle.length() || strncmp(token, this->Turtle.c_str(), this->Turtle.length()) != 0)
+                return;
+            name++;
+        }
+        else name = token;
+
+        if(!strcmp(name, "fd") || !strcmp(name, "forward") || !strcmp(name, "bk") || !strcmp(name, "back")) {
+            i = _next_token(command, i, arg);
+            if(!_parse_number(arg, &n))
+                break;
+            this->Move(name[0] == 'f' ? n : -n);
+        }
+        else if(!strcmp(name, "rt") || !strcmp(name, "right") || !strcmp(name, "lt") || !strcmp(name, "left")) {
+            i = _next_token(command, i, arg);
+            if(!_parse_number(arg, &n))
+                break;
+            this->Turn(name[0] == 'r' ? n : -n);
+        }
+        else if(!strcmp(name, "seth") || !strcmp(name, "setheading")) {
+            i = _next_token(command, i, arg);
+            if(!_parse_number(arg, &n))
+                break;
+            this->Dir = 0;
+            this->Turn(n);
+        }
+        else if(!strcmp(name, "setx") || !strcmp(name, "sety")) {
+            i = _next_token(command, i, arg);
+            if(!_parse_number(arg, &n))
+                break;
+            if(name[3] == 'x')
+                this->PosX = n;
+            else this->PosY = n;
+        }
+        else if(!strcmp(name, "setpos")) {
+            i = _next_token(command, i, arg);
+            if(strcmp(arg, "["))
+                break;
+            i = _next_token(command, i, arg);
+            if(!_parse_number(arg, &n))
+                break;
+            i = _next_token(command, i, arg);
+            if(!_parse_number(arg, &n2))
+                break;
+            i = _next_token(command, i, arg);
+            if(strcmp(arg, "]"))
+                break;
+            this->PosX = n;
+            this->PosY = n2;
+        }
+        else if(!strcmp(name, "home")) {
+            this->PosX = 0;
+            this->PosY = 0;
+            this->Dir = 0;
+        }
+        else if(!strcmp(name, "pu") || !strcmp(name, "penup"))
+            this->Down = false;
+        else if(!strcmp(name, "pd") || !strcmp(name, "pendown"))
+            this->Down = true;
+        else if(!strcmp(name, "_toll")) {      //Pen toggle procedure of LogoApi.IMP, only toggles the first turtle of the first page
+            if(this->Turtle != "Page1't1" && this->Turtle != "lap1't1")
+                break;
+            this->Down = !this->Down;
+        }
+        else if(!strcmp(name, "setpc") || !strcmp(name, "setpencolor")) {
+            i = _next_token(command, i, arg);
+            if(arg[0] == 0 || arg[0] == '[' || arg[0] == ':')
+                break;
+            this->Color = String(arg[0] == '"' ? arg + 1 : arg);
+        }
+        else break;
+        i = _next_token(command, i, token);
+    }
+    if(token[0] != 0)
+        this->Stale = true;
+}
+
+String TurtleMirror::QueryCommand() {
+    String prefix = this->Turtle;
+    prefix += "'";
+    String query = "(list ";
+    const char* reporters[] = {"xcor", "ycor", "heading", "pen", "pencolor"};
+    for(size_t i = 0; i < 5; i++) {
+        query += prefix;
+        query += reporters[i];
+        query += i < 4 ? " " : ")";
+    }
+    return query;
+}
+
+int TurtleMirror::Reconcile(const char* result) {
+    this->Recording = false;
+    char token[TURTLE_TOKEN_SIZE];
+    double values[3];
+    size_t i = _next_token(result, 0, token);
+    if(!strcmp(token, "["))
+        i = _next_token(result, i, token);
+    for(size_t j = 0; j < 3; j++) {
+        if(!_parse_number(token, &values[j]))
+            return this->_reconcile_failed();
+        i = _next_token(result, i, token);
+    }
+    //Pen states of the English and the Hungarian Imagine (other states, e.g. pe, can't be mirrored)
+    bool down;
+    if(!strcmp(token, "pd") || !strcmp(token, "pendown") || !strcmp(token, "true") || !strcmp(token, "tollatle"))
+        down = true;
+    else if(!strcmp(token, "pu") || !strcmp(token, "penup") || !strcmp(token, "false") || !strcmp(token, "tollatfel"))
+        down = false;
+    else return this->_reconcile_failed();
+    i = _next_token(result, i, token);
+    if(token[0] == 0 || token[0] == '[' || token[0] == ']')
+        return this->_reconcile_failed();
+    this->PosX = values[0];
+    this->PosY = values[1];
+    this->Dir = values[2];
+    this->Down = down;
+    this->Color = String(token);
+    this->Stale = false;
+    for(size_t j = 0; j < this->NumReplay; j++)
+        this->Apply(this->Replay[j].c_str());
+    if(this->ReplayOverflow)
+        this->Stale = true;
+    this->NumReplay = 0;
+    this->NumReconciled++;
+    return 1;
+}
+
+const char* TurtleMirror::TogglePen() const {
+    return this->Down ? "penup" : "pendown";
+}
+
+double TurtleMirror::X() const {
+    return this->PosX;
+}
+
+double TurtleMirror::Y() const {
+    return this->PosY;
+}
+
+double TurtleMirror::Heading() const {
+    return this->Dir;
+}
+
+bool TurtleMirror::PenDown() const {
+    return this->Down;
+}
+
+String TurtleMirror::PenColor() const {
+    return this->Color;
+}
+
+bool TurtleMirror::IsStale() const {
+    return this->Stale;
+}
+
+const String& TurtleMirror::GetTurtle() const {
+    return this->Turtle;
+}
+
+size_t TurtleMirror::Reconciled() const {
+    return this->NumReconciled;
+}
+
+size_t TurtleMirror::FailedReconciles() const {
+    return this->NumFailed;
+}
+
+void TurtleMirror::_query_sent() {
+    this->Recording = true;
+    this->ReplayOverflow = false;
+    this->NumReplay = 0;
+}
+
+int TurtleMirror::_reconcile_failed() {
+    this->NumReplay = 0;
+    this->NumFailed++;
+    return 0;
+}
@@ -0,0 +1,71 @@
+#ifndef TURTLEMIRROR_HPP
+#define TURTLEMIRROR_HPP
+
+#ifndef ARDUINO
+#include <string>
+using String = std::string;
+#else
+#include <Arduino.h>
+#endif
+
+#define TURTLE_REPLAY_SIZE 16
+
+/// Local model of a turtle's state, updated from the commands sent to the server
+/// The model turns stale when a command can't be followed (unknown procedure, non-literal argument), Reconcile brings it back in sync
+class TurtleMirror {
+    private:
+        String Turtle;
+        double PosX = 0;
+        double PosY = 0;
+        double Dir = 0;
+        bool Down = true;
+        String Color = "black";
+        bool Stale = false;
+        String Replay[TURTLE_REPLAY_SIZE];
+        size_t NumReplay = 0;
+        bool Recording = false;
+        bool ReplayOverflow = false;
+        size_t NumReconciled = 0;
+        size_t NumFailed = 0;
+
+        void Move(double distance);
+        void Turn(double angle);
+        int _reconcile_failed();
+    public:
+        /// @param turtle Name of the mirrored turtle, as used in the commands (e.g. Page1't1)
+        explicit TurtleMirror(const String& turtle = "Page1't1");
+
+        /// Update the model with a command sent to the server
+        /// @param command Null-terminated command, may contain more instructions
+        void Apply(const char* command);
+
+        /// Get the command reporting the state of the turtle, to be sent to the server
+        /// @return The query command
+        String QueryCommand();
+
+        /// Set the model to the result of the query command, then apply again the commands sent after the query
+        /// The model stays stale if more than TURTLE_REPLAY_SIZE commands were sent after the query
+        /// @param result The result received from the server, without the "OK: " prefix
+        /// @return 1 if the model was updated, 0 if the result couldn't be parsed
+        int Reconcile(const char* result);
+
+        /// Get the command toggling the pen, based on the mirrored pen state (the model is updated when it's sent)
+        /// @return "penup" or "pendown"
+        const char* TogglePen() const;
+
+        double X() const;
+        double Y() const;
+        double Heading() const;
+        bool PenDown() const;
+        String PenColor() const;
+        bool IsStale() const;
+        const String& GetTurtle() const;
+        /// @return Number of successful reconciles
+        size_t Reconciled() const;
+        /// @return Number of query results that couldn't be parsed
+        size_t FailedReconciles() const;
+
+        void _query_sent();
+};
+
+#endif
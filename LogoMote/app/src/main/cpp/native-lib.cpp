@@ -1,10 +1,11 @@
 #include <jni.h>
 #include <string>
+#include <cstdio>
+
+#include "Clients/SocketLogoClient.hpp"
 
 extern "C"
 {
-    #include "Clients/SocketLogoClient.hpp"
-
     SocketLogoClient* client = NULL;
 
     JNIEXPORT jboolean  JNICALL Java_com_qkrisi_logomote_MainActivity_IsConnected(JNIEnv* env, jobject)
@@ -50,4 +51,31 @@ extern "C"
             client->SendMessage(SND_COMMAND, ccommand, client->GetServerName());
             env->ReleaseStringUTFChars(command, ccommand);
     }
+
+    JNIEXPORT jlong JNICALL Java_com_qkrisi_logomote_MainActivity_GetHandle(JNIEnv* env, jobject)
+    {
+            return (jlong)client;
+    }
+
+    JNIEXPORT void JNICALL Java_com_qkrisi_logomote_MainActivity_SendCommandBuffer(JNIEnv* env, jobject, jlong handle, jobject command, jint length, jint priority)
+    {
+            auto logoClient = (LogoClient*)handle;
+            if(logoClient == NULL || priority < 0 || priority >= LOGO_PRIORITIES)
+                return;
+            auto ccommand = (const char*)env->GetDirectBufferAddress(command);
+            //The capacity is -1 if the buffer isn't direct
+            if(ccommand == NULL || length < 0 || length > env->GetDirectBufferCapacity(command))
+                return;
+            logoClient->SendCommand(ccommand, (size_t)length, (LogoPriority)priority);
+    }
+
+    JNIEXPORT void JNICALL Java_com_qkrisi_logomote_MainActivity_SendMove(JNIEnv* env, jobject, jlong handle, jint move, jint rotate)
+    {
+            auto logoClient = (LogoClient*)handle;
+            if(logoClient == NULL)
+                return;
+            char command[32];
+            int length = snprintf(command, sizeof(command), "mozgat %d %d", (int)move, (int)rotate);
+            logoClient->SendCommand(command, (size_t)length, PRIORITY_COALESCE);
+    }
 }
\ No newline at end of file
@@ -15,6 +15,8 @@ import android.widget.Button;
 
 import com.qkrisi.logomote.databinding.ActivityMainBinding;
 
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 import java.util.Objects;
 
 public class MainActivity extends AppCompatActivity implements SensorEventListener {
@@ -36,6 +38,12 @@ public class MainActivity extends AppCompatActivity implements SensorEventListen
     private int LastMove = 0;
     private int LastRotate = 0;
 
+    //PRIORITY_HIGH of LogoPriority
+    private static final int PRIORITY_HIGH = 0;
+
+    private long Handle = 0;
+    private final ByteBuffer PenCommand = DirectString("_toll");
+
     private final int OrientTreshold = 10;
     private final int OrientTreshold2 = OrientTreshold * -1;
 
@@ -56,6 +64,7 @@ public class MainActivity extends AppCompatActivity implements SensorEventListen
             public void onClick(View v) {
                 if(IsConnected())
                 {
+                    Handle = 0;
                     Disconnect();
                     connectBtn.setText("Connect");
                 }
@@ -71,6 +80,7 @@ public class MainActivity extends AppCompatActivity implements SensorEventListen
                     boolean success = !Objects.equals(name, "");
                     if(success)
                     {
+                        Handle = GetHandle();
                         connectBtn.setText("Disconnect");
                         binding.nameText.setText(name);
                     }
@@ -85,11 +95,19 @@ public class MainActivity extends AppCompatActivity implements SensorEventListen
             @Override
             public void onClick(View v) {
                 if(IsConnected())
-                    SendCommand("_toll");
+                    SendCommandBuffer(Handle, PenCommand, PenCommand.capacity(), PRIORITY_HIGH);
             }
         });
     }
 
+    private static ByteBuffer DirectString(String str)
+    {
+        byte[] bytes = str.getBytes(StandardCharsets.UTF_8);
+        ByteBuffer buffer = ByteBuffer.allocateDirect(bytes.length);
+        buffer.put(bytes);
+        return buffer;
+    }
+
     public void Alert(String msg)
     {
         AlertDialog alertDialog = new AlertDialog.Builder(MainActivity.this).create();
@@ -137,7 +155,7 @@ public class MainActivity extends AppCompatActivity implements SensorEventListen
             LastMove = move;
             LastRotate = rotate;
             if(IsConnected())
-                SendCommand(String.format("mozgat %d %d", move, rotate));
+                SendMove(Handle, move, rotate);
         }
     }
 
@@ -163,4 +181,7 @@ public class MainActivity extends AppCompatActivity implements SensorEventListen
     public native boolean IsConnected();
     public native void Disconnect();
     public native void SendCommand(String command);
+    public native long GetHandle();
+    public native void SendCommandBuffer(long handle, ByteBuffer command, int length, int priority);
+    public native void SendMove(long handle, int move, int rotate);
 }
\ No newline at end of file